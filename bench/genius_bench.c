@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "lib/ssd1306.h"
+#include "lib/entrada.h"
+#include "lib/sequencia.h"
+
+// Microbenchmarks do BitColoursLab. Cada resultado sai como uma linha JSON:
+// {"nome":"...","iteracoes":N,"total_us":T,"ns_por_iteracao":M}
+// precedida por uma linha com a versão e a plataforma, para comparar versões
+// do firmware. Uma medição que falha sai como {"nome":"...","erro":"..."}.
+
+#define PINO_I2C_SDA 14
+#define PINO_I2C_SCL 15
+#define ENDERECO_I2C 0x3C
+
+#define LARGURA_DISPLAY 128
+#define ALTURA_DISPLAY 64
+
+#define AMOSTRAS_JOYSTICK 1024 // Potência de 2
+
+#if PICO_ON_DEVICE
+#define PLATAFORMA "rp2040"
+#else
+#define PLATAFORMA "host"
+#endif
+
+ssd1306_t display;
+uint16_t amostras_x[AMOSTRAS_JOYSTICK];
+uint16_t amostras_y[AMOSTRAS_JOYSTICK];
+
+// Imprime o resultado de um benchmark
+void reportar(const char *nome, uint32_t iteracoes, uint64_t total_us)
+{
+    printf("{\"nome\":\"%s\",\"iteracoes\":%lu,\"total_us\":%llu,\"ns_por_iteracao\":%llu}\n",
+           nome, (unsigned long)iteracoes, (unsigned long long)total_us,
+           (unsigned long long)(total_us * 1000 / iteracoes));
+}
+
+// Imprime uma medição que não pôde ser feita
+void reportar_erro(const char *nome, const char *erro)
+{
+    printf("{\"nome\":\"%s\",\"erro\":\"%s\"}\n", nome, erro);
+}
+
+void medir_fill(uint32_t iteracoes)
+{
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        ssd1306_fill(&display, i & 1);
+    }
+    reportar("ssd1306_fill", iteracoes, time_us_64() - inicio);
+}
+
+void medir_draw_string(uint32_t iteracoes)
+{
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        ssd1306_draw_string(&display, "BitColoursLab", 15, 0);
+    }
+    reportar("ssd1306_draw_string", iteracoes, time_us_64() - inicio);
+}
+
+void medir_rect(uint32_t iteracoes)
+{
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        ssd1306_rect(&display, 0, 0, LARGURA_DISPLAY, ALTURA_DISPLAY, true, false);
+    }
+    reportar("ssd1306_rect_borda", iteracoes, time_us_64() - inicio);
+
+    inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        ssd1306_rect(&display, 16, 32, 64, 32, true, true);
+    }
+    reportar("ssd1306_rect_preenchido", iteracoes, time_us_64() - inicio);
+}
+
+// No host o barramento é simulado e mede apenas o custo do driver
+void medir_send_data(uint32_t iteracoes)
+{
+    // Sem display conectado as escritas recebem NACK e terminam logo, o que
+    // daria um tempo sem sentido; um byte de controle vazio confirma o painel
+    uint8_t sonda = 0x00;
+    if (i2c_write_blocking(display.i2c_port, display.address, &sonda, 1, false) != 1)
+    {
+        reportar_erro("ssd1306_send_data", "display ausente");
+        reportar_erro("ssd1306_flush_all", "display ausente");
+        return;
+    }
+
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        ssd1306_send_data(&display);
+    }
+    reportar("ssd1306_send_data", iteracoes, time_us_64() - inicio);
+
+    // Uma falha no meio (painel desconectado) só termina no tempo limite,
+    // então a medição para na primeira
+    ssd1306_t *paineis[] = {&display};
+    inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        ssd1306_request_flush(&display);
+        if (ssd1306_flush_all(paineis, 1) > 0)
+        {
+            reportar_erro("ssd1306_flush_all", "falha no envio");
+            return;
+        }
+    }
+    reportar("ssd1306_flush_all", iteracoes, time_us_64() - inicio);
+}
+
+void medir_sequencia(uint32_t iteracoes)
+{
+    uint8_t sequencia[6];
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        sequencia_gerar(sequencia, sizeof(sequencia));
+    }
+    reportar("sequencia_gerar", iteracoes, time_us_64() - inicio);
+}
+
+// Publica um evento para cada jogador com o mesmo instante e só depois consome
+// os dois, de modo que a primeira consulta de cada par passa pelo desempate.
+// Cada iteração é um par de eventos.
+void medir_filas(uint32_t iteracoes)
+{
+    evento_entrada_t evento;
+
+    // Garante que os eventos já estejam fora da janela de espera
+    sleep_us(ENTRADA_JANELA_US);
+
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        entrada_publicar(0, i % 3, 0);
+        entrada_publicar(1, (i + 1) % 3, 0);
+        entrada_consumir_proximo(&evento);
+        entrada_consumir_proximo(&evento);
+    }
+    reportar("entrada_fila", iteracoes, time_us_64() - inicio);
+}
+
+// Filtro e decodificador sobre um sinal sintético com ruído que alterna entre
+// o centro e cada uma das direções
+void medir_joystick(uint32_t iteracoes)
+{
+    const int16_t desvios[][2] = {{0, 0}, {0, 1900}, {0, 0}, {-1900, 0}, {0, 0}, {1900, 0}, {0, 0}, {0, -1900}};
+
+    for (uint32_t i = 0; i < AMOSTRAS_JOYSTICK; i++)
+    {
+        const int16_t *desvio = desvios[i * 8 / AMOSTRAS_JOYSTICK];
+        amostras_x[i] = 2048 + desvio[0] + (i % 7) * 20 - 60;
+        amostras_y[i] = 2048 + desvio[1] + (i % 5) * 20 - 40;
+    }
+
+    entrada_joystick_definir_jogador(ENTRADA_SEM_JOGADOR);
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < iteracoes; i++)
+    {
+        uint32_t k = i & (AMOSTRAS_JOYSTICK - 1);
+        entrada_processar_joystick(amostras_x[k], amostras_y[k], i);
+    }
+    reportar("entrada_joystick", iteracoes, time_us_64() - inicio);
+}
+
+void executar_benchmarks()
+{
+    printf("{\"versao\":\"%s\",\"plataforma\":\"%s\"}\n", GENIUS_VERSAO, PLATAFORMA);
+
+    // Semente fixa para que a sequência gerada seja a mesma em toda execução
+    srand(1);
+
+    medir_fill(100);
+    medir_draw_string(200);
+    medir_rect(200);
+    medir_send_data(100);
+    medir_sequencia(10000);
+    medir_filas(10000);
+    medir_joystick(10000);
+}
+
+int main()
+{
+    stdio_init_all();
+
+    i2c_init(i2c1, 400 * 1000);
+#if PICO_ON_DEVICE
+    gpio_set_function(PINO_I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(PINO_I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(PINO_I2C_SDA);
+    gpio_pull_up(PINO_I2C_SCL);
+#endif
+
+    ssd1306_init(&display, LARGURA_DISPLAY, ALTURA_DISPLAY, false, ENDERECO_I2C, i2c1);
+    ssd1306_config(&display);
+
+#if PICO_ON_DEVICE
+    // Repete periodicamente para que o monitor serial possa conectar a qualquer
+    // momento
+    while (true)
+    {
+        sleep_ms(5000);
+        executar_benchmarks();
+    }
+#else
+    executar_benchmarks();
+    return 0;
+#endif
+}
@@ -0,0 +1,63 @@
+#ifndef I2C_SIMULADO_H
+#define I2C_SIMULADO_H
+
+// Barramento I2C simulado para compilar o driver ssd1306 no host: as escritas
+// são contadas e, por padrão, toda transferência termina na hora. O FIFO tem
+// uma única posição, então cada byte escrito em data_cmd é contado na próxima
+// consulta de espaço livre (ou em i2c_simulado_bytes_escritos). Os comandos
+// de um byte (prefixo 0x80) ficam registrados em ordem para os testes.
+//
+// Com i2c_simulado_simular_tempo cada controlador passa a levar 9 bits por
+// byte na velocidade de i2c_init: i2c_write_blocking espera a transferência e
+// o FIFO só libera espaço quando o byte anterior termina de sair.
+
+#include "pico/stdlib.h"
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200u
+
+#define I2C_SIMULADO_FIFO_VAZIO 0xFFFFFFFFu
+#define I2C_SIMULADO_MAX_COMANDOS 1024
+
+typedef struct {
+  volatile uint32_t data_cmd;
+  volatile uint32_t enable;
+  volatile uint32_t tar;
+  volatile uint32_t raw_intr_stat;
+  volatile uint32_t clr_tx_abrt;
+  volatile uint32_t clr_stop_det;
+} i2c_hw_t;
+
+typedef struct {
+  i2c_hw_t hw;
+  size_t bytes_escritos;
+  size_t transacoes; // Inclui as recusadas por NACK
+  uint8_t comandos[I2C_SIMULADO_MAX_COMANDOS];
+  size_t num_comandos; // Continua contando depois que o registro enche
+  uint baudrate;
+  bool simular_tempo;
+  bool parada_pendente; // O byte em transmissão termina com STOP
+  uint64_t ocupado_ate_ns;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+size_t i2c_get_write_available(i2c_inst_t *i2c);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+  return &i2c->hw;
+}
+
+size_t i2c_simulado_bytes_escritos(i2c_inst_t *i2c);
+void i2c_simulado_simular_nack(i2c_inst_t *i2c, bool nack);
+void i2c_simulado_limpar_comandos(i2c_inst_t *i2c);
+void i2c_simulado_simular_tempo(i2c_inst_t *i2c, bool ligado);
+
+#endif
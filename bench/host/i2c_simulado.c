@@ -0,0 +1,96 @@
+#include "hardware/i2c.h"
+
+#define HW_INICIAL {.data_cmd = I2C_SIMULADO_FIFO_VAZIO, .raw_intr_stat = I2C_IC_RAW_INTR_STAT_STOP_DET_BITS}
+
+i2c_inst_t i2c0_inst = {.hw = HW_INICIAL};
+i2c_inst_t i2c1_inst = {.hw = HW_INICIAL};
+
+static uint64_t i2c_simulado_agora_ns() {
+  return time_us_64() * 1000;
+}
+
+// Ocupa o barramento com len bytes a partir do fim da transferência anterior
+static void i2c_simulado_transmitir(i2c_inst_t *i2c, size_t len) {
+  if (!i2c->simular_tempo)
+    return;
+  uint64_t agora = i2c_simulado_agora_ns();
+  if (i2c->ocupado_ate_ns < agora)
+    i2c->ocupado_ate_ns = agora;
+  i2c->ocupado_ate_ns += len * 9ull * 1000000000ull / i2c->baudrate;
+}
+
+static bool i2c_simulado_ocupado(i2c_inst_t *i2c) {
+  return i2c->simular_tempo && i2c_simulado_agora_ns() < i2c->ocupado_ate_ns;
+}
+
+// Conta o byte deixado em data_cmd desde a última consulta e começa a
+// transmiti-lo. STOP_DET só volta a valer quando um byte com STOP termina.
+static void i2c_simulado_esvaziar_fifo(i2c_inst_t *i2c) {
+  if (i2c->hw.data_cmd != I2C_SIMULADO_FIFO_VAZIO) {
+    i2c->bytes_escritos++;
+    i2c->parada_pendente = i2c->hw.data_cmd & I2C_IC_DATA_CMD_STOP_BITS;
+    i2c->hw.raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+    i2c_simulado_transmitir(i2c, 1);
+    i2c->hw.data_cmd = I2C_SIMULADO_FIFO_VAZIO;
+  }
+  if (i2c->parada_pendente && !i2c_simulado_ocupado(i2c)) {
+    i2c->parada_pendente = false;
+    i2c->hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+  }
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+  i2c->hw.data_cmd = I2C_SIMULADO_FIFO_VAZIO;
+  i2c->bytes_escritos = 0;
+  i2c->transacoes = 0;
+  i2c->num_comandos = 0;
+  i2c->baudrate = baudrate;
+  i2c->simular_tempo = false;
+  i2c->parada_pendente = false;
+  i2c->ocupado_ate_ns = 0;
+  return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+  i2c->transacoes++;
+  if (i2c->hw.raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    return PICO_ERROR_GENERIC;
+  i2c->bytes_escritos += len;
+  i2c_simulado_transmitir(i2c, len);
+  while (i2c_simulado_ocupado(i2c))
+    tight_loop_contents();
+  if (len == 2 && src[0] == 0x80) {
+    if (i2c->num_comandos < I2C_SIMULADO_MAX_COMANDOS)
+      i2c->comandos[i2c->num_comandos] = src[1];
+    i2c->num_comandos++;
+  }
+  return len;
+}
+
+size_t i2c_get_write_available(i2c_inst_t *i2c) {
+  i2c_simulado_esvaziar_fifo(i2c);
+  return i2c_simulado_ocupado(i2c) ? 0 : 1;
+}
+
+size_t i2c_simulado_bytes_escritos(i2c_inst_t *i2c) {
+  i2c_simulado_esvaziar_fifo(i2c);
+  return i2c->bytes_escritos;
+}
+
+// Com nack ligado, toda transferência é abortada como se o painel não
+// respondesse
+void i2c_simulado_simular_nack(i2c_inst_t *i2c, bool nack) {
+  if (nack)
+    i2c->hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+  else
+    i2c->hw.raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+}
+
+void i2c_simulado_limpar_comandos(i2c_inst_t *i2c) {
+  i2c->num_comandos = 0;
+}
+
+void i2c_simulado_simular_tempo(i2c_inst_t *i2c, bool ligado) {
+  i2c->simular_tempo = ligado;
+  i2c->ocupado_ate_ns = 0;
+}
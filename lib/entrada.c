@@ -0,0 +1,221 @@
+#include "entrada.h"
+#include <stdlib.h>
+
+#define CENTRO_ADC 2048
+#define ZONA_MORTA 1000              // Distância do centro para reconhecer uma direção
+#define ZONA_RETORNO 600             // Distância para considerar que o joystick voltou
+#define PESO_FILTRO 2                // Média móvel exponencial com peso 1/4
+#define ATRASO_MAXIMO_FILTRO_US 2000 // Limite para antecipar o instante de um evento
+
+// Fila circular com um único produtor (interrupção) e um único consumidor
+// (laço principal): cada índice só é escrito por um dos lados
+typedef struct {
+  evento_entrada_t eventos[ENTRADA_TAMANHO_FILA];
+  volatile uint8_t cabeca;
+  volatile uint8_t cauda;
+} fila_entrada_t;
+
+static fila_entrada_t filas[ENTRADA_MAX_JOGADORES];
+static uint8_t ultimo_empate = 0;
+
+static volatile uint8_t jogador_joystick = ENTRADA_SEM_JOGADOR;
+static volatile direcao_t direcao_atual = DIRECAO_NENHUMA;
+static filtro_joystick_t filtro = {CENTRO_ADC << PESO_FILTRO, CENTRO_ADC << PESO_FILTRO, CENTRO_ADC, CENTRO_ADC};
+static bool saindo_do_centro = false;
+static uint64_t instante_saida_us;
+static volatile bool houve_clique = false;
+static volatile uint64_t instante_clique_us;
+
+// Cores do jogo: 0 vermelho, 1 azul, 2 verde (mesma disposição dos botões)
+static const int8_t cor_por_direcao[] = {
+  [DIRECAO_NENHUMA] = -1,
+  [DIRECAO_CIMA] = 0,
+  [DIRECAO_BAIXO] = -1,
+  [DIRECAO_ESQUERDA] = 2,
+  [DIRECAO_DIREITA] = 1
+};
+
+static bool entrada_publicar_evento(uint8_t jogador, evento_entrada_t evento) {
+  if (jogador >= ENTRADA_MAX_JOGADORES)
+    return false;
+
+  fila_entrada_t *fila = &filas[jogador];
+  uint8_t cabeca = fila->cabeca;
+  if ((uint8_t)(cabeca - fila->cauda) >= ENTRADA_TAMANHO_FILA)
+    return false;
+
+  fila->eventos[cabeca & (ENTRADA_TAMANHO_FILA - 1)] = evento;
+  __compiler_memory_barrier();
+  fila->cabeca = cabeca + 1;
+  return true;
+}
+
+bool entrada_publicar(uint8_t jogador, uint8_t cor, uint64_t instante_us) {
+  return entrada_publicar_evento(jogador, (evento_entrada_t){cor, false, instante_us});
+}
+
+// Apertar o botão do joystick quase sempre também inclina a alavanca, e essa
+// direção viraria uma jogada a mais (no versus, um erro do adversário, que usa
+// as direções enquanto o botão é o vermelho do jogador 1)
+static bool entrada_perto_do_clique(const evento_entrada_t *evento) {
+  if (!evento->joystick || !houve_clique)
+    return false;
+
+  uint64_t clique = instante_clique_us;
+  if (evento->instante_us >= clique)
+    return evento->instante_us - clique < ENTRADA_CLIQUE_DEPOIS_US;
+  return clique - evento->instante_us < ENTRADA_CLIQUE_ANTES_US;
+}
+
+// Direções esperam ENTRADA_CLIQUE_ANTES_US para que um clique logo depois
+// ainda possa descartá-las
+static bool entrada_pronto(const evento_entrada_t *evento, uint64_t janela_us) {
+  if (evento->joystick && janela_us < ENTRADA_CLIQUE_ANTES_US)
+    janela_us = ENTRADA_CLIQUE_ANTES_US;
+  return time_us_64() - evento->instante_us >= janela_us;
+}
+
+// Retorna o evento mais antigo do jogador, já descartando as direções
+// causadas por cliques do joystick
+static bool entrada_espiar(uint8_t jogador, evento_entrada_t *evento) {
+  fila_entrada_t *fila = &filas[jogador];
+  while (true) {
+    uint8_t cauda = fila->cauda;
+    if (cauda == fila->cabeca)
+      return false;
+
+    __compiler_memory_barrier();
+    *evento = fila->eventos[cauda & (ENTRADA_TAMANHO_FILA - 1)];
+    if (!entrada_perto_do_clique(evento))
+      return true;
+    fila->cauda = cauda + 1;
+  }
+}
+
+bool entrada_consumir(uint8_t jogador, evento_entrada_t *evento) {
+  if (!entrada_espiar(jogador, evento) || !entrada_pronto(evento, 0))
+    return false;
+  filas[jogador].cauda++;
+  return true;
+}
+
+// Entrega o evento mais antigo entre todos os jogadores e retorna o dono dele
+// (ou -1). Um evento só sai depois de ENTRADA_JANELA_US (ou
+// ENTRADA_CLIQUE_ANTES_US, se for uma direção), para que uma entrada anterior
+// ainda não publicada (amostragem do joystick) não perca a vez.
+// Instantes idênticos são decididos alternadamente entre os jogadores.
+int entrada_consumir_proximo(evento_entrada_t *evento) {
+  int escolhido = -1;
+  bool empate = false;
+  evento_entrada_t candidato;
+
+  for (uint8_t jogador = 0; jogador < ENTRADA_MAX_JOGADORES; ++jogador) {
+    evento_entrada_t atual;
+    if (!entrada_espiar(jogador, &atual))
+      continue;
+
+    if (escolhido < 0 || atual.instante_us < candidato.instante_us) {
+      escolhido = jogador;
+      candidato = atual;
+      empate = false;
+    } else if (atual.instante_us == candidato.instante_us) {
+      empate = true;
+      if (escolhido == ultimo_empate) {
+        escolhido = jogador;
+        candidato = atual;
+      }
+    }
+  }
+
+  if (escolhido < 0 || !entrada_pronto(&candidato, ENTRADA_JANELA_US))
+    return -1;
+
+  if (empate)
+    ultimo_empate = escolhido;
+  filas[escolhido].cauda++;
+  *evento = candidato;
+  return escolhido;
+}
+
+// Descarta entradas feitas fora da vez do jogador
+void entrada_limpar(uint8_t jogador) {
+  filas[jogador].cauda = filas[jogador].cabeca;
+}
+
+void entrada_filtro_iniciar(filtro_joystick_t *filtro, uint16_t x, uint16_t y) {
+  filtro->soma_x = x << PESO_FILTRO;
+  filtro->soma_y = y << PESO_FILTRO;
+  filtro->x = x;
+  filtro->y = y;
+}
+
+// Média móvel exponencial em ponto fixo: a soma guarda o valor filtrado
+// multiplicado por 2^PESO_FILTRO e nunca é negativa, então o deslocamento não
+// tem viés para nenhum dos lados e o filtro converge exatamente para a entrada
+void entrada_filtrar(filtro_joystick_t *filtro, uint16_t x, uint16_t y) {
+  filtro->soma_x += x - (filtro->soma_x >> PESO_FILTRO);
+  filtro->soma_y += y - (filtro->soma_y >> PESO_FILTRO);
+  filtro->x = filtro->soma_x >> PESO_FILTRO;
+  filtro->y = filtro->soma_y >> PESO_FILTRO;
+}
+
+direcao_t entrada_decodificar_direcao(int32_t x, int32_t y, int32_t zona_morta) {
+  int32_t dx = x - CENTRO_ADC;
+  int32_t dy = y - CENTRO_ADC;
+
+  if (abs(dx) < zona_morta && abs(dy) < zona_morta)
+    return DIRECAO_NENHUMA;
+
+  if (abs(dx) > abs(dy))
+    return dx > 0 ? DIRECAO_DIREITA : DIRECAO_ESQUERDA;
+  return dy > 0 ? DIRECAO_CIMA : DIRECAO_BAIXO;
+}
+
+// Gera um evento apenas quando o joystick sai do centro, como um botão. A zona
+// de retorno menor evita eventos repetidos com o joystick parado na borda.
+// O filtro atrasa a detecção em algumas amostras, então o evento leva o
+// instante da primeira amostra bruta que saiu da zona morta (limitado a
+// ATRASO_MAXIMO_FILTRO_US), para competir de igual com os botões.
+void entrada_processar_joystick(uint16_t x, uint16_t y, uint64_t instante_us) {
+  entrada_filtrar(&filtro, x, y);
+
+  direcao_t anterior = direcao_atual;
+  if (anterior == DIRECAO_NENHUMA) {
+    if (entrada_decodificar_direcao(x, y, ZONA_MORTA) == DIRECAO_NENHUMA) {
+      saindo_do_centro = false;
+    } else if (!saindo_do_centro) {
+      saindo_do_centro = true;
+      instante_saida_us = instante_us;
+    }
+  }
+
+  int32_t zona = anterior == DIRECAO_NENHUMA ? ZONA_MORTA : ZONA_RETORNO;
+  direcao_t direcao = entrada_decodificar_direcao(filtro.x, filtro.y, zona);
+
+  if (anterior == DIRECAO_NENHUMA && direcao != DIRECAO_NENHUMA) {
+    uint64_t instante_evento = saindo_do_centro ? instante_saida_us : instante_us;
+    if (instante_us > ATRASO_MAXIMO_FILTRO_US && instante_evento < instante_us - ATRASO_MAXIMO_FILTRO_US)
+      instante_evento = instante_us - ATRASO_MAXIMO_FILTRO_US;
+    if (cor_por_direcao[direcao] >= 0)
+      entrada_publicar_evento(jogador_joystick, (evento_entrada_t){cor_por_direcao[direcao], true, instante_evento});
+    saindo_do_centro = false;
+  }
+
+  direcao_atual = direcao;
+}
+
+// Chamada da interrupção do botão do joystick em toda borda, antes do debounce
+void entrada_joystick_registrar_clique(uint64_t instante_us) {
+  instante_clique_us = instante_us;
+  houve_clique = true;
+}
+
+// ENTRADA_SEM_JOGADOR desliga a publicação de eventos do joystick
+void entrada_joystick_definir_jogador(uint8_t jogador) {
+  jogador_joystick = jogador;
+}
+
+// Direção atual já filtrada, para navegação em menus
+direcao_t entrada_joystick_direcao() {
+  return direcao_atual;
+}
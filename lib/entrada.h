@@ -0,0 +1,48 @@
+#ifndef ENTRADA_H
+#define ENTRADA_H
+
+#include "pico/stdlib.h"
+
+#define ENTRADA_MAX_JOGADORES 2
+#define ENTRADA_TAMANHO_FILA 16 // Precisa ser potência de 2
+#define ENTRADA_SEM_JOGADOR 0xFF
+#define ENTRADA_JANELA_US 4000  // Maior atraso entre o instante de uma entrada e sua publicação
+
+// Direções do joystick perto de um clique do próprio joystick são descartadas
+#define ENTRADA_CLIQUE_ANTES_US 20000
+#define ENTRADA_CLIQUE_DEPOIS_US 150000
+
+typedef enum {
+  DIRECAO_NENHUMA,
+  DIRECAO_CIMA,
+  DIRECAO_BAIXO,
+  DIRECAO_ESQUERDA,
+  DIRECAO_DIREITA
+} direcao_t;
+
+typedef struct {
+  int32_t soma_x, soma_y; // Acumuladores em ponto fixo
+  int32_t x, y;           // Valores filtrados
+} filtro_joystick_t;
+
+typedef struct {
+  uint8_t cor;
+  bool joystick; // Gerado por uma direção do joystick
+  uint64_t instante_us;
+} evento_entrada_t;
+
+bool entrada_publicar(uint8_t jogador, uint8_t cor, uint64_t instante_us);
+bool entrada_consumir(uint8_t jogador, evento_entrada_t *evento);
+int entrada_consumir_proximo(evento_entrada_t *evento);
+void entrada_limpar(uint8_t jogador);
+
+void entrada_filtro_iniciar(filtro_joystick_t *filtro, uint16_t x, uint16_t y);
+void entrada_filtrar(filtro_joystick_t *filtro, uint16_t x, uint16_t y);
+direcao_t entrada_decodificar_direcao(int32_t x, int32_t y, int32_t zona_morta);
+void entrada_processar_joystick(uint16_t x, uint16_t y, uint64_t instante_us);
+void entrada_joystick_registrar_clique(uint64_t instante_us);
+void entrada_joystick_iniciar();
+void entrada_joystick_definir_jogador(uint8_t jogador);
+direcao_t entrada_joystick_direcao();
+
+#endif
@@ -0,0 +1,70 @@
+#include "entrada.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+
+// Amostragem do joystick: a parte dependente do hardware da entrada, separada
+// de entrada.c para que filas, filtro e decodificador compilem fora da placa
+
+#define PINO_JOYSTICK_X 26
+#define PINO_JOYSTICK_Y 27
+#define CANAL_JOYSTICK_X 0
+#define CANAL_JOYSTICK_Y 1
+
+// O ADC converte X e Y alternadamente (round robin) e o DMA grava as
+// amostras num anel; o processamento só lê o anel a cada milissegundo
+#define DIVISOR_ADC 11999            // 48 MHz / (1 + 11999) = 4 kHz, 2 kHz por eixo
+#define PERIODO_CONVERSAO_US 250
+#define PERIODO_PROCESSAMENTO_US 1000
+#define AMOSTRAS_ANEL 64             // Potência de 2, X nos índices pares
+#define BITS_ANEL 7                  // log2(AMOSTRAS_ANEL * sizeof(uint16_t))
+
+static repeating_timer_t timer_joystick;
+
+static uint16_t anel_adc[AMOSTRAS_ANEL] __attribute__((aligned(AMOSTRAS_ANEL * sizeof(uint16_t))));
+static uint16_t posicao_lida = 0;
+static uint canal_dma;
+
+// Consome os pares X/Y gravados pelo DMA desde a última chamada. O instante de
+// cada par é estimado pela quantidade de conversões feitas depois dele.
+static bool processar_anel(repeating_timer_t *timer) {
+  uint64_t agora = time_us_64();
+  uint16_t escrita = (dma_hw->ch[canal_dma].write_addr - (uintptr_t) anel_adc) / sizeof(uint16_t);
+
+  while (((escrita - posicao_lida) & (AMOSTRAS_ANEL - 1)) >= 2) {
+    uint16_t x = anel_adc[posicao_lida] & 0x0FFF;
+    uint16_t y = anel_adc[posicao_lida + 1] & 0x0FFF;
+    posicao_lida = (posicao_lida + 2) & (AMOSTRAS_ANEL - 1);
+
+    uint16_t restantes = (escrita - posicao_lida) & (AMOSTRAS_ANEL - 1);
+    entrada_processar_joystick(x, y, agora - restantes * PERIODO_CONVERSAO_US);
+  }
+
+  // A contagem só se esgota após ~12 dias ligados
+  if (!dma_channel_is_busy(canal_dma))
+    dma_channel_set_trans_count(canal_dma, 0xFFFFFFFF, true);
+  return true;
+}
+
+// Requer adc_init() já chamado. Depois daqui o ADC fica em modo contínuo e
+// adc_read() não deve mais ser usado.
+void entrada_joystick_iniciar() {
+  adc_gpio_init(PINO_JOYSTICK_X);
+  adc_gpio_init(PINO_JOYSTICK_Y);
+  adc_select_input(CANAL_JOYSTICK_X);
+  adc_set_round_robin((1u << CANAL_JOYSTICK_X) | (1u << CANAL_JOYSTICK_Y));
+  adc_fifo_setup(true, true, 1, false, false);
+  adc_set_clkdiv(DIVISOR_ADC);
+  adc_fifo_drain();
+
+  canal_dma = dma_claim_unused_channel(true);
+  dma_channel_config config = dma_channel_get_default_config(canal_dma);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+  channel_config_set_read_increment(&config, false);
+  channel_config_set_write_increment(&config, true);
+  channel_config_set_ring(&config, true, BITS_ANEL);
+  channel_config_set_dreq(&config, DREQ_ADC);
+  dma_channel_configure(canal_dma, &config, anel_adc, &adc_hw->fifo, 0xFFFFFFFF, true);
+
+  adc_run(true);
+  add_repeating_timer_us(-PERIODO_PROCESSAMENTO_US, processar_anel, NULL, &timer_joystick);
+}
@@ -0,0 +1,27 @@
+#include "sequencia.h"
+#include <stdlib.h>
+
+#define NUM_CORES 3
+
+// As três primeiras posições trazem cada cor uma vez (embaralhadas) e o
+// restante é sorteado livremente
+void sequencia_gerar(uint8_t *sequencia, uint8_t tamanho) {
+  uint8_t indices[NUM_CORES] = {0, 1, 2};
+  uint8_t temp;
+  int j;
+
+  // Embaralhar as cores iniciais
+  for (int i = NUM_CORES - 1; i > 0; i--) {
+    j = rand() % (i + 1);
+    temp = indices[i];
+    indices[i] = indices[j];
+    indices[j] = temp;
+  }
+
+  for (uint8_t i = 0; i < NUM_CORES && i < tamanho; i++)
+    sequencia[i] = indices[i];
+
+  // Gerar o restante da sequência de forma aleatória
+  for (uint8_t i = NUM_CORES; i < tamanho; i++)
+    sequencia[i] = rand() % NUM_CORES;
+}
@@ -0,0 +1,8 @@
+#ifndef SEQUENCIA_H
+#define SEQUENCIA_H
+
+#include <stdint.h>
+
+void sequencia_gerar(uint8_t *sequencia, uint8_t tamanho);
+
+#endif
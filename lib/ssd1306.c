@@ -1,3 +1,4 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
 
@@ -11,6 +12,12 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->scrolling = false;
+  ssd->dirty = false;
+  ssd->flushing = false;
+  ssd->flush_failed = false;
+  ssd->flush_pos = 0;
+  ssd->flush_start_us = 0;
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -20,12 +27,12 @@ void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
   ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
   ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
+  ssd1306_command(ssd, ssd->height - 1);
   ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
   ssd1306_command(ssd, SET_DISP_OFFSET);
   ssd1306_command(ssd, 0x00);
   ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
+  ssd1306_command(ssd, ssd->height == 32 ? 0x02 : 0x12);
   ssd1306_command(ssd, SET_DISP_CLK_DIV);
   ssd1306_command(ssd, 0x80);
   ssd1306_command(ssd, SET_PRECHARGE);
@@ -52,13 +59,20 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
+static void ssd1306_set_window(ssd1306_t *ssd) {
+  // A RAM não pode ser escrita com a rolagem ativa
+  if (ssd->scrolling)
+    ssd1306_scroll_stop(ssd);
   ssd1306_command(ssd, SET_COL_ADDR);
   ssd1306_command(ssd, 0);
   ssd1306_command(ssd, ssd->width - 1);
   ssd1306_command(ssd, SET_PAGE_ADDR);
   ssd1306_command(ssd, 0);
   ssd1306_command(ssd, ssd->pages - 1);
+}
+
+void ssd1306_send_data(ssd1306_t *ssd) {
+  ssd1306_set_window(ssd);
   i2c_write_blocking(
     ssd->i2c_port,
     ssd->address,
@@ -66,10 +80,260 @@ void ssd1306_send_data(ssd1306_t *ssd) {
     ssd->bufsize,
     false
   );
+  ssd->dirty = false;
+}
+
+void ssd1306_request_flush(ssd1306_t *ssd) {
+  ssd->dirty = true;
+}
+
+// Envio não bloqueante: os comandos de janela são enviados na hora e o
+// framebuffer é despejado aos poucos no FIFO por ssd1306_flush_poll, o que
+// permite alimentar vários controladores I2C ao mesmo tempo
+void ssd1306_flush_begin(ssd1306_t *ssd) {
+  ssd1306_set_window(ssd);
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  (void) hw->clr_stop_det;
+
+  ssd->flush_pos = 0;
+  ssd->flush_start_us = time_us_64();
+  ssd->flushing = true;
+  ssd->flush_failed = false;
+  ssd->dirty = false;
+}
+
+// Retorna true quando o quadro terminou de sair. Se o envio for abortado (NACK,
+// painel ausente) ou passar de SSD1306_FLUSH_TIMEOUT_US, flush_failed é marcado
+// e o painel volta a ficar pendente.
+bool ssd1306_flush_poll(ssd1306_t *ssd) {
+  if (!ssd->flushing)
+    return true;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    (void) hw->clr_tx_abrt;
+    ssd->flushing = false;
+    ssd->flush_failed = true;
+    ssd->dirty = true;
+    return true;
+  }
+
+  if (time_us_64() - ssd->flush_start_us > SSD1306_FLUSH_TIMEOUT_US) {
+    // Desabilitar o controlador descarta o que restou no FIFO
+    hw->enable = 0;
+    hw->enable = 1;
+    ssd->flushing = false;
+    ssd->flush_failed = true;
+    ssd->dirty = true;
+    return true;
+  }
+
+  size_t available = i2c_get_write_available(ssd->i2c_port);
+  while (available-- && ssd->flush_pos < ssd->bufsize) {
+    uint32_t data_cmd = ssd->ram_buffer[ssd->flush_pos++];
+    if (ssd->flush_pos == ssd->bufsize)
+      data_cmd |= I2C_IC_DATA_CMD_STOP_BITS;
+    hw->data_cmd = data_cmd;
+  }
+
+  if (ssd->flush_pos < ssd->bufsize || !(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS))
+    return false;
+
+  (void) hw->clr_stop_det;
+  ssd->flushing = false;
+  return true;
+}
+
+static bool ssd1306_bus_busy(ssd1306_t **panels, size_t count, i2c_inst_t *i2c) {
+  for (size_t i = 0; i < count; ++i) {
+    if (panels[i]->flushing && panels[i]->i2c_port == i2c)
+      return true;
+  }
+  return false;
+}
+
+// Envia todos os painéis pendentes alternando entre eles: painéis em
+// barramentos diferentes transmitem em paralelo, painéis no mesmo barramento
+// esperam a vez. Cada painel tem uma única tentativa por chamada; os que
+// falharem continuam pendentes para a próxima. Retorna quantos falharam.
+size_t ssd1306_flush_all(ssd1306_t **panels, size_t count) {
+  for (size_t i = 0; i < count; ++i)
+    panels[i]->flush_failed = false;
+
+  bool pending = true;
+  while (pending) {
+    pending = false;
+    for (size_t i = 0; i < count; ++i) {
+      ssd1306_t *ssd = panels[i];
+      if (ssd->flushing) {
+        if (!ssd1306_flush_poll(ssd))
+          pending = true;
+      } else if (ssd->dirty && !ssd->flush_failed) {
+        if (!ssd1306_bus_busy(panels, count, ssd->i2c_port))
+          ssd1306_flush_begin(ssd);
+        pending = true;
+      }
+    }
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (panels[i]->flush_failed)
+      failed++;
+  }
+  return failed;
+}
+
+#if !PICO_ON_DEVICE
+// Rolagem em software para o host, onde não há controlador: desloca as páginas
+// do framebuffer em uma coluna, com a coluna que sai voltando do outro lado
+static void ssd1306_scroll_buffer(ssd1306_t *ssd, bool left, uint8_t start_page, uint8_t end_page) {
+  uint8_t *buffer = ssd->ram_buffer + 1;
+  uint16_t last = (ssd->width - 1) * ssd->pages;
+
+  for (uint8_t page = start_page; page <= end_page && page < ssd->pages; ++page) {
+    if (left) {
+      uint8_t first = buffer[page];
+      for (uint16_t i = page; i < last + page; i += ssd->pages)
+        buffer[i] = buffer[i + ssd->pages];
+      buffer[last + page] = first;
+    } else {
+      uint8_t first = buffer[last + page];
+      for (uint16_t i = last + page; i > page; i -= ssd->pages)
+        buffer[i] = buffer[i - ssd->pages];
+      buffer[page] = first;
+    }
+  }
+}
+#endif
+
+// Rolagem horizontal feita pelo próprio controlador: depois de configurada
+// não há tráfego no barramento até ser interrompida. No host cada chamada
+// desloca o framebuffer uma coluna e o reenvia.
+void ssd1306_scroll_horizontal(ssd1306_t *ssd, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_interval_t interval) {
+  ssd1306_scroll_stop(ssd);
+#if !PICO_ON_DEVICE
+  ssd1306_scroll_buffer(ssd, left, start_page, end_page);
+  ssd1306_send_data(ssd);
+#endif
+  ssd1306_command(ssd, SET_HORIZ_SCROLL | (left ? 0x01 : 0x00));
+  ssd1306_command(ssd, 0x00);
+  ssd1306_command(ssd, start_page);
+  ssd1306_command(ssd, interval);
+  ssd1306_command(ssd, end_page);
+  ssd1306_command(ssd, 0x00);
+  ssd1306_command(ssd, 0xFF);
+  ssd1306_command(ssd, SET_SCROLL_ON);
+  ssd->scrolling = true;
+}
+
+void ssd1306_scroll_diagonal(ssd1306_t *ssd, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_interval_t interval, uint8_t vertical_offset) {
+  ssd1306_scroll_stop(ssd);
+  ssd1306_command(ssd, SET_VERT_SCROLL_AREA);
+  ssd1306_command(ssd, 0x00);
+  ssd1306_command(ssd, ssd->height);
+  ssd1306_command(ssd, SET_DIAG_SCROLL + (left ? 0x01 : 0x00));
+  ssd1306_command(ssd, 0x00);
+  ssd1306_command(ssd, start_page);
+  ssd1306_command(ssd, interval);
+  ssd1306_command(ssd, end_page);
+  ssd1306_command(ssd, vertical_offset);
+  ssd1306_command(ssd, SET_SCROLL_ON);
+  ssd->scrolling = true;
+}
+
+// Após desativar a rolagem o conteúdo da RAM fica deslocado e precisa ser
+// reenviado com ssd1306_send_data
+void ssd1306_scroll_stop(ssd1306_t *ssd) {
+  ssd1306_command(ssd, SET_SCROLL_OFF);
+  if (ssd->scrolling) {
+    ssd->scrolling = false;
+    ssd1306_set_start_line(ssd, 0);
+  }
+}
+
+void ssd1306_set_start_line(ssd1306_t *ssd, uint8_t line) {
+  ssd1306_command(ssd, SET_DISP_START_LINE | (line & 0x3F));
+}
+
+// Zera as linhas da GDDRAM além da altura do painel (ex.: 32..63 num 128x32),
+// que nunca são escritas por ssd1306_send_data
+static void ssd1306_clear_unused_rows(ssd1306_t *ssd) {
+  uint8_t zeros[17] = {0x40};
+  size_t remaining = (SSD1306_RAM_ROWS / 8 - ssd->pages) * ssd->width;
+
+  ssd1306_command(ssd, SET_COL_ADDR);
+  ssd1306_command(ssd, 0);
+  ssd1306_command(ssd, ssd->width - 1);
+  ssd1306_command(ssd, SET_PAGE_ADDR);
+  ssd1306_command(ssd, ssd->pages);
+  ssd1306_command(ssd, SSD1306_RAM_ROWS / 8 - 1);
+  while (remaining > 0) {
+    size_t chunk = remaining < 16 ? remaining : 16;
+    i2c_write_blocking(ssd->i2c_port, ssd->address, zeros, chunk + 1, false);
+    remaining -= chunk;
+  }
+}
+
+// Um quadro da transição. No host não há GDDRAM, então a linha inicial também
+// é aplicada ao próprio framebuffer (a partir do conteúdo original), que é o
+// que o simulador mostra
+static void ssd1306_roll_frame(ssd1306_t *ssd, const uint8_t *content, int line) {
+  ssd1306_set_start_line(ssd, line);
+#if !PICO_ON_DEVICE
+  for (uint8_t x = 0; x < ssd->width; ++x) {
+    for (uint8_t y = 0; y < ssd->height; ++y) {
+      uint8_t row = (line + y) % SSD1306_RAM_ROWS;
+      bool value = row < ssd->height && (content[(row >> 3) + x * ssd->pages + 1] & (1 << (row & 0b111)));
+      ssd1306_pixel(ssd, x, y, value);
+    }
+  }
+  ssd1306_send_data(ssd);
+#else
+  (void) content;
+#endif
+}
+
+// Transição de tela: o quadro é enviado uma única vez e depois deslizado até
+// a posição final mudando apenas a linha inicial (1 comando por quadro). Em
+// painéis menores que a GDDRAM as linhas sobrando são zeradas e a transição
+// começa nelas, com a tela em branco, para que o quadro entre só por cima.
+void ssd1306_roll_in(ssd1306_t *ssd, uint8_t step, uint32_t frame_delay_ms) {
+  if (step == 0)
+    step = 1;
+  if (ssd->scrolling)
+    ssd1306_scroll_stop(ssd);
+  if (ssd->height < SSD1306_RAM_ROWS)
+    ssd1306_clear_unused_rows(ssd);
+
+  uint8_t *content = NULL;
+#if !PICO_ON_DEVICE
+  content = malloc(ssd->bufsize);
+  memcpy(content, ssd->ram_buffer, ssd->bufsize);
+#endif
+
+  int line = ssd->height < SSD1306_RAM_ROWS ? ssd->height : SSD1306_RAM_ROWS - step;
+  ssd1306_roll_frame(ssd, content, line);
+#if PICO_ON_DEVICE
+  ssd1306_send_data(ssd);
+#endif
+  for (line -= step; line > 0; line -= step) {
+    sleep_ms(frame_delay_ms);
+    ssd1306_roll_frame(ssd, content, line);
+  }
+  sleep_ms(frame_delay_ms);
+  ssd1306_roll_frame(ssd, content, 0);
+  free(content);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = (y >> 3) + x * ssd->pages + 1;
   uint8_t pixel = (y & 0b111);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
@@ -2,8 +2,8 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
-#define WIDTH 128
-#define HEIGHT 64
+#define SSD1306_RAM_ROWS 64
+#define SSD1306_FLUSH_TIMEOUT_US 200000
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -22,9 +22,25 @@ typedef enum {
   SET_DISP_CLK_DIV = 0xD5,
   SET_PRECHARGE = 0xD9,
   SET_VCOM_DESEL = 0xDB,
-  SET_CHARGE_PUMP = 0x8D
+  SET_CHARGE_PUMP = 0x8D,
+  SET_HORIZ_SCROLL = 0x26,
+  SET_DIAG_SCROLL = 0x29,
+  SET_SCROLL_OFF = 0x2E,
+  SET_SCROLL_ON = 0x2F,
+  SET_VERT_SCROLL_AREA = 0xA3
 } ssd1306_command_t;
 
+typedef enum {
+  SCROLL_5_FRAMES = 0x00,
+  SCROLL_64_FRAMES = 0x01,
+  SCROLL_128_FRAMES = 0x02,
+  SCROLL_256_FRAMES = 0x03,
+  SCROLL_3_FRAMES = 0x04,
+  SCROLL_4_FRAMES = 0x05,
+  SCROLL_25_FRAMES = 0x06,
+  SCROLL_2_FRAMES = 0x07
+} ssd1306_scroll_interval_t;
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -32,6 +48,12 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  bool scrolling;
+  bool dirty;
+  bool flushing;
+  bool flush_failed;
+  size_t flush_pos;
+  uint64_t flush_start_us;
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
@@ -39,6 +61,17 @@ void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
 
+void ssd1306_request_flush(ssd1306_t *ssd);
+void ssd1306_flush_begin(ssd1306_t *ssd);
+bool ssd1306_flush_poll(ssd1306_t *ssd);
+size_t ssd1306_flush_all(ssd1306_t **panels, size_t count);
+
+void ssd1306_scroll_horizontal(ssd1306_t *ssd, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_interval_t interval);
+void ssd1306_scroll_diagonal(ssd1306_t *ssd, bool left, uint8_t start_page, uint8_t end_page, ssd1306_scroll_interval_t interval, uint8_t vertical_offset);
+void ssd1306_scroll_stop(ssd1306_t *ssd);
+void ssd1306_set_start_line(ssd1306_t *ssd, uint8_t line);
+void ssd1306_roll_in(ssd1306_t *ssd, uint8_t step, uint32_t frame_delay_ms);
+
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
@@ -6,6 +6,8 @@
 #include "hardware/i2c.h"
 #include "lib/ssd1306.h"
 #include "lib/font.h"
+#include "lib/entrada.h"
+#include "lib/sequencia.h"
 #include <stdlib.h>
 #include <time.h>
 
@@ -27,7 +29,9 @@
 #define LARGURA_DISPLAY 128
 #define ALTURA_DISPLAY 64
 
-#define ATRASO_DEBOUNCE_MS 300
+// Tempo sem bordas para um toque valer. Curto para não impedir que o jogador
+// repita uma cor rapidamente (no versus o joystick não tem esse limite)
+#define ATRASO_DEBOUNCE_MS 30
 
 // Definição das notas musicais (frequências em Hz)
 #define NOTE_C4 262
@@ -55,11 +59,20 @@ uint8_t sequencia[MAX_SEQUENCIA];
 uint8_t nivel = 1;
 uint8_t indice_jogador = 0;
 
+// Modos de jogo
+typedef enum
+{
+    MODO_SOLO,
+    MODO_CORRIDA,   // Os dois jogadores repetem a mesma sequência ao mesmo tempo
+    MODO_ALTERNADO  // Cada jogador repete a sequência na sua vez
+} modo_jogo_t;
+
 // Protótipos de funções
 void configurar_gpio();
 void configurar_i2c();
 void inicializar_display();
 void callback_botao(uint gpio, uint32_t eventos);
+bool toque_valido(volatile absolute_time_t *ultima_borda, absolute_time_t agora, uint32_t eventos);
 void desenhar_borda();
 void gerar_sequencia();
 void mostrar_sequencia();
@@ -68,7 +81,16 @@ void atualizar_display(uint8_t nivel_atual, uint8_t indice_atual, bool game_over
 void exibir_tela_inicial();
 void exibir_tela_instrucoes();
 void exibir_segunda_tela_instrucoes();
+void desenhar_mensagem_centralizada(char *mensagem);
 void exibir_mensagem_centralizada(char *mensagem);
+void desenhar_menu_modo(uint8_t opcao);
+modo_jogo_t escolher_modo();
+void jogar_solo();
+void jogar_versus(bool alternado);
+int jogar_rodada_corrida();
+int jogar_rodada_alternada();
+bool receber_sequencia_jogador(uint8_t jogador, uint64_t *duracao_us);
+void exibir_placar(uint8_t *pontos, char *mensagem);
 void tocar_nota(uint pino_buzzer, uint frequencia, uint duracao_ms);
 void tocar_introducao();
 void tocar_som_erro();
@@ -149,12 +171,18 @@ void tocar_introducao()
     sleep_ms(200);                           // Pausa final mais longa
 }
 
-// Função para exibir mensagens centralizadas com borda
-void exibir_mensagem_centralizada(char *mensagem)
+// Função para desenhar mensagens centralizadas com borda no framebuffer
+void desenhar_mensagem_centralizada(char *mensagem)
 {
     ssd1306_fill(&display, false);
     desenhar_borda();
     ssd1306_draw_string(&display, mensagem, 25, ALTURA_DISPLAY / 2 - 8);
+}
+
+// Função para exibir mensagens centralizadas com borda
+void exibir_mensagem_centralizada(char *mensagem)
+{
+    desenhar_mensagem_centralizada(mensagem);
     ssd1306_send_data(&display);
 }
 
@@ -208,36 +236,278 @@ void atualizar_display(uint8_t nivel_atual, uint8_t indice_atual, bool game_over
         exibir_mensagem_centralizada("GAME OVER!");
     }
 
+    if (!vez_jogador && !game_over)
+    {
+        char faixa[16];
+        snprintf(faixa, sizeof(faixa), "NIVEL %d", nivel_atual);
+        ssd1306_draw_string(&display, faixa, 35, 48);
+    }
+
     ssd1306_send_data(&display);
+
+    // A faixa do nível rola por hardware enquanto a sequência é exibida
+    if (!vez_jogador && !game_over)
+    {
+        ssd1306_scroll_horizontal(&display, true, 6, 6, SCROLL_5_FRAMES);
+    }
 }
 
 // Gera uma nova sequência aleatória
 void gerar_sequencia()
 {
-    uint8_t cores_base[3] = {0, 1, 2};
-    uint8_t indices[3] = {0, 1, 2};
-    uint8_t temp;
-    int j;
+    sequencia_gerar(sequencia, MAX_SEQUENCIA);
+}
+
+// Desenha o menu de modos com o cursor na opção selecionada
+void desenhar_menu_modo(uint8_t opcao)
+{
+    ssd1306_fill(&display, false);
+    ssd1306_draw_string(&display, "Modo de jogo", 15, 0);
+    ssd1306_draw_string(&display, "A Solo", 20, 16);
+    ssd1306_draw_string(&display, "B Corrida", 20, 32);
+    ssd1306_draw_string(&display, "Alternado", 20, 48);
+    ssd1306_rect(&display, 17 + opcao * 16, 6, 6, 6, true, true);
+    ssd1306_send_data(&display);
+}
+
+// Exibe o menu de modos: o joystick move o cursor e seu botão confirma; os
+// botões A e B escolhem direto
+modo_jogo_t escolher_modo()
+{
+    uint8_t opcao = MODO_SOLO;
+    direcao_t anterior = DIRECAO_NENHUMA;
+
+    desenhar_menu_modo(opcao);
+    entrada_joystick_definir_jogador(ENTRADA_SEM_JOGADOR);
+    entrada_limpar(0);
+
+    while (true)
+    {
+        direcao_t direcao = entrada_joystick_direcao();
+        if (direcao != anterior)
+        {
+            if (direcao == DIRECAO_CIMA && opcao > MODO_SOLO)
+            {
+                desenhar_menu_modo(--opcao);
+            }
+            else if (direcao == DIRECAO_BAIXO && opcao < MODO_ALTERNADO)
+            {
+                desenhar_menu_modo(++opcao);
+            }
+            anterior = direcao;
+        }
+
+        evento_entrada_t evento;
+        if (entrada_consumir(0, &evento))
+        {
+            if (evento.cor == 2)
+                return MODO_SOLO;
+            if (evento.cor == 1)
+                return MODO_CORRIDA;
+            return opcao;
+        }
+
+        sleep_ms(10);
+    }
+}
+
+// Partida de um jogador; retorna no game over ou ao completar a sequência
+void jogar_solo()
+{
+    nivel = 1;
+    gerar_sequencia();
+    entrada_joystick_definir_jogador(0);
+
+    while (true)
+    {
+        atualizar_display(nivel, indice_jogador, false, false);
+        mostrar_sequencia();
+
+        indice_jogador = 0;
+        entrada_limpar(0);
+        atualizar_display(nivel, indice_jogador, false, true);
+
+        while (indice_jogador < nivel)
+        {
+            evento_entrada_t evento;
+            if (!entrada_consumir(0, &evento))
+            {
+                tight_loop_contents();
+                continue;
+            }
+
+            if (!verificar_jogada(evento.cor))
+            {
+                atualizar_display(nivel, indice_jogador, true, false);
+                tocar_som_erro();
+                sleep_ms(2000);
+                return;
+            }
+        }
+
+        nivel++;
+        if (nivel > MAX_SEQUENCIA)
+        {
+            desenhar_mensagem_centralizada("PARABENS");
+            ssd1306_roll_in(&display, 4, 20);
+            tocar_melodia_parabens();
+            sleep_ms(3000);
+            return;
+        }
+
+        sleep_ms(1000);
+    }
+}
+
+// Partida de dois jogadores: jogador 1 nos botões, jogador 2 nas direções do
+// joystick. Cada nível vale um ponto e a partida termina na sequência máxima.
+void jogar_versus(bool alternado)
+{
+    uint8_t pontos[ENTRADA_MAX_JOGADORES] = {0, 0};
+    char mensagem[16];
+
+    gerar_sequencia();
+    entrada_joystick_definir_jogador(1);
+
+    for (nivel = 1; nivel <= MAX_SEQUENCIA; nivel++)
+    {
+        int vencedor = alternado ? jogar_rodada_alternada() : jogar_rodada_corrida();
+
+        if (vencedor < 0)
+        {
+            snprintf(mensagem, sizeof(mensagem), "EMPATE");
+        }
+        else
+        {
+            pontos[vencedor]++;
+            snprintf(mensagem, sizeof(mensagem), "PONTO J%d", vencedor + 1);
+        }
+        exibir_placar(pontos, mensagem);
+        sleep_ms(2000);
+    }
+
+    if (pontos[0] == pontos[1])
+    {
+        snprintf(mensagem, sizeof(mensagem), "EMPATE");
+    }
+    else
+    {
+        snprintf(mensagem, sizeof(mensagem), "J%d VENCEU", pontos[0] > pontos[1] ? 1 : 2);
+    }
+    desenhar_mensagem_centralizada(mensagem);
+    ssd1306_roll_in(&display, 4, 20);
+    tocar_melodia_parabens();
+    sleep_ms(3000);
+}
+
+// Os dois jogadores repetem a sequência ao mesmo tempo. As entradas são
+// processadas na ordem dos instantes capturados nas interrupções, então vence
+// quem terminou primeiro mesmo que o laço principal atrase. Errar entrega a
+// rodada ao adversário. Retorna o vencedor.
+int jogar_rodada_corrida()
+{
+    uint8_t indices[ENTRADA_MAX_JOGADORES] = {0, 0};
+
+    atualizar_display(nivel, 0, false, false);
+    mostrar_sequencia();
 
-    // Embaralhar as cores iniciais
-    for (int i = 2; i > 0; i--)
+    entrada_limpar(0);
+    entrada_limpar(1);
+    exibir_mensagem_centralizada("JA");
+
+    while (true)
     {
-        j = rand() % (i + 1);
-        temp = indices[i];
-        indices[i] = indices[j];
-        indices[j] = temp;
+        evento_entrada_t evento;
+        int jogador = entrada_consumir_proximo(&evento);
+        if (jogador < 0)
+        {
+            tight_loop_contents();
+            continue;
+        }
+
+        if (sequencia[indices[jogador]] != evento.cor)
+        {
+            tocar_som_erro();
+            return 1 - jogador;
+        }
+
+        if (++indices[jogador] == nivel)
+            return jogador;
     }
+}
 
-    for (int i = 0; i < 3; i++)
+// Cada jogador repete a sequência na sua vez. Se os dois acertarem, vence o
+// mais rápido (medido pelos instantes das interrupções). Retorna o vencedor ou
+// -1 em caso de empate.
+int jogar_rodada_alternada()
+{
+    bool acertou[ENTRADA_MAX_JOGADORES];
+    uint64_t duracao_us[ENTRADA_MAX_JOGADORES];
+    char mensagem[16];
+
+    for (uint8_t jogador = 0; jogador < ENTRADA_MAX_JOGADORES; jogador++)
     {
-        sequencia[i] = cores_base[indices[i]];
+        snprintf(mensagem, sizeof(mensagem), "VEZ J%d", jogador + 1);
+        exibir_mensagem_centralizada(mensagem);
+        sleep_ms(1000);
+
+        atualizar_display(nivel, 0, false, false);
+        mostrar_sequencia();
+
+        exibir_mensagem_centralizada(mensagem);
+        acertou[jogador] = receber_sequencia_jogador(jogador, &duracao_us[jogador]);
+        if (!acertou[jogador])
+            tocar_som_erro();
     }
 
-    // Gerar o restante da sequência de forma aleatória
-    for (uint8_t i = 3; i < MAX_SEQUENCIA; i++)
+    if (acertou[0] != acertou[1])
+        return acertou[0] ? 0 : 1;
+    if (!acertou[0] || duracao_us[0] == duracao_us[1])
+        return -1;
+    return duracao_us[0] < duracao_us[1] ? 0 : 1;
+}
+
+// Recebe a sequência do nível atual de um jogador. A duração vai do início da
+// vez até o instante da última entrada.
+bool receber_sequencia_jogador(uint8_t jogador, uint64_t *duracao_us)
+{
+    uint64_t inicio = time_us_64();
+    entrada_limpar(jogador);
+
+    for (uint8_t indice = 0; indice < nivel;)
     {
-        sequencia[i] = rand() % 3;
+        evento_entrada_t evento;
+        if (!entrada_consumir(jogador, &evento))
+        {
+            tight_loop_contents();
+            continue;
+        }
+
+        // Uma direção do joystick é publicada com atraso e pode ter escapado
+        // de entrada_limpar; como a limpeza, ela é de antes da vez
+        if (evento.instante_us < inicio)
+            continue;
+
+        if (sequencia[indice] != evento.cor)
+            return false;
+
+        indice++;
+        *duracao_us = evento.instante_us - inicio;
     }
+    return true;
+}
+
+// Exibe o placar da partida em versus
+void exibir_placar(uint8_t *pontos, char *mensagem)
+{
+    char placar[16];
+    snprintf(placar, sizeof(placar), "J1 %d  J2 %d", pontos[0], pontos[1]);
+
+    ssd1306_fill(&display, false);
+    desenhar_borda();
+    ssd1306_draw_string(&display, placar, 20, 16);
+    ssd1306_draw_string(&display, mensagem, 20, 40);
+    ssd1306_send_data(&display);
 }
 
 // Função principal
@@ -257,6 +527,10 @@ int main()
     absolute_time_t now = get_absolute_time();
     srand(to_us_since_boot(now) + random_adc_value);
 
+    // Amostragem contínua do joystick por DMA (o ADC não pode mais ser lido
+    // diretamente a partir daqui)
+    entrada_joystick_iniciar();
+
     configurar_gpio();
     configurar_i2c();
     inicializar_display();
@@ -270,81 +544,17 @@ int main()
     exibir_tela_instrucoes();
     exibir_segunda_tela_instrucoes();
 
-    gerar_sequencia();
-
-    bool game_over = false;
-
     while (true)
     {
-        atualizar_display(nivel, indice_jogador, false, false);
-        mostrar_sequencia();
-
-        indice_jogador = 0;
-        while (indice_jogador < nivel)
+        modo_jogo_t modo = escolher_modo();
+        if (modo == MODO_SOLO)
         {
-            atualizar_display(nivel, indice_jogador, false, true);
-
-            if (gpio_get(PINO_BOTAO_B) == 0)
-            {
-                if (!verificar_jogada(1))
-                {
-                    game_over = true;
-                    atualizar_display(nivel, indice_jogador, true, false);
-                    tocar_som_erro();
-                    sleep_ms(2000);
-                    nivel = 1;
-                    gerar_sequencia();
-                    game_over = false;
-                    break;
-                }
-                sleep_ms(ATRASO_DEBOUNCE_MS);
-            }
-            if (gpio_get(PINO_BOTAO_A) == 0)
-            {
-                if (!verificar_jogada(2))
-                {
-                    game_over = true;
-                    atualizar_display(nivel, indice_jogador, true, false);
-                    tocar_som_erro();
-                    sleep_ms(2000);
-                    nivel = 1;
-                    gerar_sequencia();
-                    game_over = false;
-                    break;
-                }
-                sleep_ms(ATRASO_DEBOUNCE_MS);
-            }
-            if (gpio_get(PINO_BOTAO_JOYSTICK) == 0)
-            {
-                if (!verificar_jogada(0))
-                {
-                    game_over = true;
-                    atualizar_display(nivel, indice_jogador, true, false);
-                    tocar_som_erro();
-                    sleep_ms(2000);
-                    nivel = 1;
-                    gerar_sequencia();
-                    game_over = false;
-                    break;
-                }
-                sleep_ms(ATRASO_DEBOUNCE_MS);
-            }
+            jogar_solo();
         }
-
-        if (indice_jogador == nivel)
+        else
         {
-            nivel++;
-            if (nivel > MAX_SEQUENCIA)
-            {
-                exibir_mensagem_centralizada("PARABENS");
-                tocar_melodia_parabens();
-                sleep_ms(3000);
-                nivel = 1;
-                gerar_sequencia();
-            }
+            jogar_versus(modo == MODO_ALTERNADO);
         }
-
-        sleep_ms(1000);
     }
 
     return 0;
@@ -356,17 +566,17 @@ void configurar_gpio()
     gpio_init(PINO_BOTAO_B);
     gpio_set_dir(PINO_BOTAO_B, GPIO_IN);
     gpio_pull_up(PINO_BOTAO_B);
-    gpio_set_irq_enabled_with_callback(PINO_BOTAO_B, GPIO_IRQ_EDGE_FALL, true, &callback_botao);
+    gpio_set_irq_enabled_with_callback(PINO_BOTAO_B, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &callback_botao);
 
     gpio_init(PINO_BOTAO_A);
     gpio_set_dir(PINO_BOTAO_A, GPIO_IN);
     gpio_pull_up(PINO_BOTAO_A);
-    gpio_set_irq_enabled(PINO_BOTAO_A, GPIO_IRQ_EDGE_FALL, true);
+    gpio_set_irq_enabled(PINO_BOTAO_A, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true);
 
     gpio_init(PINO_BOTAO_JOYSTICK);
     gpio_set_dir(PINO_BOTAO_JOYSTICK, GPIO_IN);
     gpio_pull_up(PINO_BOTAO_JOYSTICK);
-    gpio_set_irq_enabled(PINO_BOTAO_JOYSTICK, GPIO_IRQ_EDGE_FALL, true);
+    gpio_set_irq_enabled(PINO_BOTAO_JOYSTICK, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true);
 
     // Configura os pinos dos LEDs para PWM
     configurar_pwm(PINO_LED_VERMELHO);
@@ -401,25 +611,45 @@ void inicializar_display()
 void callback_botao(uint gpio, uint32_t eventos)
 {
     absolute_time_t agora = get_absolute_time();
+    uint8_t cor;
 
     if (gpio == PINO_BOTAO_B)
     {
-        if (absolute_time_diff_us(ultimo_tempo_botao_b, agora) < ATRASO_DEBOUNCE_MS * 1000)
+        if (!toque_valido(&ultimo_tempo_botao_b, agora, eventos))
             return;
-        ultimo_tempo_botao_b = agora;
+        cor = 1;
     }
     else if (gpio == PINO_BOTAO_A)
     {
-        if (absolute_time_diff_us(ultimo_tempo_botao_a, agora) < ATRASO_DEBOUNCE_MS * 1000)
+        if (!toque_valido(&ultimo_tempo_botao_a, agora, eventos))
             return;
-        ultimo_tempo_botao_a = agora;
+        cor = 2;
     }
     else if (gpio == PINO_BOTAO_JOYSTICK)
     {
-        if (absolute_time_diff_us(ultimo_tempo_botao_joystick, agora) < ATRASO_DEBOUNCE_MS * 1000)
+        // Descarta as direções geradas pela alavanca ao apertar ou soltar
+        entrada_joystick_registrar_clique(to_us_since_boot(agora));
+        if (!toque_valido(&ultimo_tempo_botao_joystick, agora, eventos))
             return;
-        ultimo_tempo_botao_joystick = agora;
+        cor = 0;
+    }
+    else
+    {
+        return;
     }
+
+    // O instante da interrupção decide a ordem das jogadas
+    entrada_publicar(0, cor, to_us_since_boot(agora));
+}
+
+// Debounce por tempo de silêncio: toda borda (descida ou subida) reinicia a
+// contagem, e só uma descida após ATRASO_DEBOUNCE_MS sem bordas conta como
+// toque. Assim a trepidação ao soltar o botão não gera um toque falso.
+bool toque_valido(volatile absolute_time_t *ultima_borda, absolute_time_t agora, uint32_t eventos)
+{
+    bool silencio = absolute_time_diff_us(*ultima_borda, agora) >= ATRASO_DEBOUNCE_MS * 1000;
+    *ultima_borda = agora;
+    return silencio && (eventos & GPIO_IRQ_EDGE_FALL);
 }
 
 // Desenha a borda no display
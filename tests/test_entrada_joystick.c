@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "lib/entrada.h"
+
+// Filtro, decodificador e detecção de eventos do joystick com sinais
+// sintéticos: zona morta, histerese da zona de retorno, ruído no centro e na
+// borda, o instante atribuído a cada evento e o descarte das direções perto de
+// um clique. As amostras seguem o relógio real, já que as direções ficam
+// retidas na fila por ENTRADA_CLIQUE_ANTES_US.
+
+#define CENTRO 2048
+#define ZONA_MORTA 1000
+#define ZONA_RETORNO 600
+#define PERIODO_US 500 // Um par de conversões X/Y do ADC
+#define ATRASO_MAXIMO_FILTRO_US 2000
+#define AMOSTRAS_ESTAVEIS 40
+
+#define VERIFICAR(condicao)                                              \
+    do                                                                   \
+    {                                                                    \
+        if (!(condicao))                                                 \
+        {                                                                \
+            printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #condicao); \
+            falhas++;                                                    \
+        }                                                                \
+    } while (0)
+
+int falhas = 0;
+uint64_t instante_us;
+
+// Processa uma amostra com desvio (dx, dy) do centro e retorna o instante dela
+uint64_t amostrar(int32_t dx, int32_t dy)
+{
+    uint64_t instante = instante_us;
+    while (time_us_64() < instante)
+        tight_loop_contents();
+    entrada_processar_joystick(CENTRO + dx, CENTRO + dy, instante);
+    instante_us += PERIODO_US;
+    return instante;
+}
+
+void manter(int32_t dx, int32_t dy, uint32_t amostras)
+{
+    for (uint32_t i = 0; i < amostras; i++)
+        amostrar(dx, dy);
+}
+
+// Espera a retenção das direções e consome todos os eventos do jogador 0,
+// guardando o último
+uint32_t contar_eventos(evento_entrada_t *ultimo)
+{
+    evento_entrada_t evento;
+    uint32_t eventos = 0;
+    while (time_us_64() < instante_us + ENTRADA_CLIQUE_ANTES_US)
+        tight_loop_contents();
+    while (entrada_consumir(0, &evento))
+    {
+        if (ultimo)
+            *ultimo = evento;
+        eventos++;
+    }
+    return eventos;
+}
+
+void voltar_ao_centro()
+{
+    manter(0, 0, AMOSTRAS_ESTAVEIS);
+    entrada_limpar(0);
+}
+
+void testar_filtro_simetrico()
+{
+    filtro_joystick_t filtro;
+
+    // Desvios pequenos para os dois lados acomodam no valor exato
+    entrada_filtro_iniciar(&filtro, CENTRO, CENTRO);
+    for (int i = 0; i < AMOSTRAS_ESTAVEIS; i++)
+        entrada_filtrar(&filtro, CENTRO + 2, CENTRO - 2);
+    VERIFICAR(filtro.x == CENTRO + 2);
+    VERIFICAR(filtro.y == CENTRO - 2);
+
+    for (int i = 0; i < AMOSTRAS_ESTAVEIS; i++)
+        entrada_filtrar(&filtro, CENTRO - 2, CENTRO + 2);
+    VERIFICAR(filtro.x == CENTRO - 2);
+    VERIFICAR(filtro.y == CENTRO + 2);
+
+    // Extremos do ADC
+    for (int i = 0; i < AMOSTRAS_ESTAVEIS; i++)
+        entrada_filtrar(&filtro, 4095, 0);
+    VERIFICAR(filtro.x == 4095);
+    VERIFICAR(filtro.y == 0);
+
+    for (int i = 0; i < AMOSTRAS_ESTAVEIS; i++)
+        entrada_filtrar(&filtro, 0, 4095);
+    VERIFICAR(filtro.x == 0);
+    VERIFICAR(filtro.y == 4095);
+}
+
+void testar_decodificacao()
+{
+    VERIFICAR(entrada_decodificar_direcao(CENTRO, CENTRO, ZONA_MORTA) == DIRECAO_NENHUMA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO + 999, CENTRO - 999, ZONA_MORTA) == DIRECAO_NENHUMA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO + 1000, CENTRO, ZONA_MORTA) == DIRECAO_DIREITA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO - 1000, CENTRO, ZONA_MORTA) == DIRECAO_ESQUERDA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO, CENTRO + 1000, ZONA_MORTA) == DIRECAO_CIMA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO, CENTRO - 1000, ZONA_MORTA) == DIRECAO_BAIXO);
+
+    // Na diagonal vence o eixo com maior desvio
+    VERIFICAR(entrada_decodificar_direcao(CENTRO + 1200, CENTRO + 1100, ZONA_MORTA) == DIRECAO_DIREITA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO - 1100, CENTRO + 1200, ZONA_MORTA) == DIRECAO_CIMA);
+
+    VERIFICAR(entrada_decodificar_direcao(CENTRO + 700, CENTRO, ZONA_MORTA) == DIRECAO_NENHUMA);
+    VERIFICAR(entrada_decodificar_direcao(CENTRO + 700, CENTRO, ZONA_RETORNO) == DIRECAO_DIREITA);
+}
+
+void testar_zona_morta()
+{
+    manter(ZONA_MORTA - 100, 0, AMOSTRAS_ESTAVEIS);
+    manter(0, -(ZONA_MORTA - 100), AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(NULL) == 0);
+
+    // Picos isolados fora da zona morta são absorvidos pelo filtro
+    for (int i = 0; i < AMOSTRAS_ESTAVEIS; i++)
+        amostrar(i % 8 == 0 ? 1900 : 0, 0);
+    VERIFICAR(contar_eventos(NULL) == 0);
+    voltar_ao_centro();
+}
+
+void testar_histerese()
+{
+    evento_entrada_t evento;
+
+    manter(1900, 0, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.cor == 1);
+
+    // Entre a zona de retorno e a zona morta o joystick continua na borda
+    manter((ZONA_MORTA + ZONA_RETORNO) / 2, 0, AMOSTRAS_ESTAVEIS);
+    manter(1900, 0, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(NULL) == 0);
+
+    // Só depois de voltar para dentro da zona de retorno conta de novo
+    manter(ZONA_RETORNO - 100, 0, AMOSTRAS_ESTAVEIS);
+    manter(1900, 0, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.cor == 1);
+    voltar_ao_centro();
+}
+
+void testar_ruido()
+{
+    const int32_t ruido[] = {0, 300, -250, 150, -300, 50, 250, -150};
+
+    for (int i = 0; i < 4 * AMOSTRAS_ESTAVEIS; i++)
+        amostrar(ruido[i % 8], ruido[(i + 3) % 8]);
+    VERIFICAR(contar_eventos(NULL) == 0);
+
+    // Ruído em torno do limite da zona morta gera um único evento
+    evento_entrada_t evento;
+    for (int i = 0; i < 4 * AMOSTRAS_ESTAVEIS; i++)
+        amostrar(ruido[(i + 3) % 8], ZONA_MORTA + ruido[i % 8]);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.cor == 0);
+    voltar_ao_centro();
+
+    for (int i = 0; i < 4 * AMOSTRAS_ESTAVEIS; i++)
+        amostrar(-ZONA_MORTA + ruido[i % 8], ruido[(i + 5) % 8]);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.cor == 2);
+    voltar_ao_centro();
+}
+
+void testar_instante()
+{
+    evento_entrada_t evento;
+
+    // O evento leva o instante da primeira amostra fora da zona morta, e não
+    // o da amostra em que o filtro reconheceu a direção
+    uint64_t saida = amostrar(1900, 0);
+    manter(1900, 0, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.instante_us == saida);
+    voltar_ao_centro();
+
+    // Um pico isolado antes da saída não antecipa o instante
+    amostrar(0, 1900);
+    manter(0, 0, 4);
+    saida = amostrar(0, 1900);
+    manter(0, 1900, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.instante_us == saida);
+    voltar_ao_centro();
+
+    // Com um desvio logo acima da zona morta o filtro demora e a antecipação
+    // fica limitada
+    saida = amostrar(-(ZONA_MORTA + 20), 0);
+    uint64_t deteccao = 0;
+    for (int i = 0; i < 2 * AMOSTRAS_ESTAVEIS && !deteccao; i++)
+    {
+        uint64_t instante = amostrar(-(ZONA_MORTA + 20), 0);
+        if (contar_eventos(&evento))
+            deteccao = instante;
+    }
+    VERIFICAR(deteccao > saida + ATRASO_MAXIMO_FILTRO_US);
+    VERIFICAR(evento.instante_us == deteccao - ATRASO_MAXIMO_FILTRO_US);
+    voltar_ao_centro();
+}
+
+// Mantém o joystick no centro até o último clique deixar de valer
+void esperar_fim_do_clique()
+{
+    manter(0, 0, ENTRADA_CLIQUE_DEPOIS_US / PERIODO_US);
+    entrada_limpar(0);
+}
+
+void testar_clique()
+{
+    evento_entrada_t evento;
+
+    // Inclinação pouco antes do clique: a direção ainda está retida quando ele
+    // chega e é descartada
+    amostrar(1900, 0);
+    manter(1900, 0, 10);
+    VERIFICAR(!entrada_consumir(0, &evento));
+    entrada_joystick_registrar_clique(instante_us);
+    VERIFICAR(contar_eventos(NULL) == 0);
+    voltar_ao_centro();
+    esperar_fim_do_clique();
+
+    // Inclinação ao apertar o botão do joystick
+    entrada_joystick_registrar_clique(instante_us);
+    manter(0, 1900, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(NULL) == 0);
+    voltar_ao_centro();
+
+    // Os botões no instante do clique não são afetados
+    entrada_joystick_registrar_clique(instante_us);
+    entrada_publicar(0, 0, instante_us);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(!evento.joystick);
+    esperar_fim_do_clique();
+
+    // Longe do clique a direção volta a contar
+    uint64_t saida = amostrar(-1900, 0);
+    manter(-1900, 0, AMOSTRAS_ESTAVEIS);
+    VERIFICAR(contar_eventos(&evento) == 1);
+    VERIFICAR(evento.joystick && evento.cor == 2 && evento.instante_us == saida);
+    voltar_ao_centro();
+}
+
+int main()
+{
+    instante_us = time_us_64();
+    entrada_joystick_definir_jogador(0);
+
+    testar_filtro_simetrico();
+    testar_decodificacao();
+    testar_zona_morta();
+    testar_histerese();
+    testar_ruido();
+    testar_instante();
+    testar_clique();
+
+    if (falhas)
+    {
+        printf("%d verificações falharam\n", falhas);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "lib/ssd1306.h"
+
+// Dois painéis independentes em barramentos diferentes (128x64 no i2c0 e
+// 128x32 no i2c1) sobre o barramento simulado: isolamento dos framebuffers,
+// bytes enviados por barramento, recuperação de NACK e taxa agregada. A taxa é
+// medida com o tempo de transferência simulado e comparada com os mesmos dois
+// painéis dividindo um único barramento.
+
+#define ENDERECO_I2C 0x3C
+#define COMANDOS_JANELA 6 // Comandos de 2 bytes antes de cada quadro
+#define BYTES_JANELA (COMANDOS_JANELA * 2)
+#define QUADROS_TAXA 20
+#define VELOCIDADE_I2C (400 * 1000)
+
+#define VERIFICAR(condicao)                                              \
+    do                                                                   \
+    {                                                                    \
+        if (!(condicao))                                                 \
+        {                                                                \
+            printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #condicao); \
+            falhas++;                                                    \
+        }                                                                \
+    } while (0)
+
+int falhas = 0;
+
+ssd1306_t painel_a;
+ssd1306_t painel_b;
+
+bool framebuffer_vazio(ssd1306_t *ssd)
+{
+    for (size_t i = 1; i < ssd->bufsize; i++)
+    {
+        if (ssd->ram_buffer[i] != 0)
+            return false;
+    }
+    return ssd->ram_buffer[0] == 0x40;
+}
+
+void testar_isolamento()
+{
+    ssd1306_fill(&painel_a, true);
+    ssd1306_draw_string(&painel_a, "Jogador 1", 0, 0);
+    ssd1306_rect(&painel_a, 0, 0, 128, 64, true, true);
+    VERIFICAR(framebuffer_vazio(&painel_b));
+
+    uint8_t copia_a[128 * 8 + 1];
+    memcpy(copia_a, painel_a.ram_buffer, painel_a.bufsize);
+
+    // Desenhos que ultrapassam o painel de 32 linhas são recortados
+    ssd1306_fill(&painel_b, true);
+    ssd1306_pixel(&painel_b, 127, 63, true);
+    ssd1306_rect(&painel_b, 0, 0, 128, 64, false, true);
+    ssd1306_draw_string(&painel_b, "Jogador 2", 0, 24);
+    VERIFICAR(memcmp(copia_a, painel_a.ram_buffer, painel_a.bufsize) == 0);
+
+    ssd1306_fill(&painel_b, false);
+    VERIFICAR(framebuffer_vazio(&painel_b));
+    VERIFICAR(memcmp(copia_a, painel_a.ram_buffer, painel_a.bufsize) == 0);
+
+    // Linhas abaixo de 32 não podem cair na coluna seguinte do próprio painel
+    ssd1306_pixel(&painel_b, 0, 40, true);
+    ssd1306_hline(&painel_b, 0, 127, 32, true);
+    VERIFICAR(framebuffer_vazio(&painel_b));
+}
+
+void testar_bytes_por_barramento()
+{
+    ssd1306_t *paineis[] = {&painel_a, &painel_b};
+    size_t inicio_a = i2c_simulado_bytes_escritos(i2c0);
+    size_t inicio_b = i2c_simulado_bytes_escritos(i2c1);
+
+    ssd1306_request_flush(&painel_a);
+    ssd1306_request_flush(&painel_b);
+    VERIFICAR(ssd1306_flush_all(paineis, 2) == 0);
+
+    VERIFICAR(i2c_simulado_bytes_escritos(i2c0) - inicio_a == BYTES_JANELA + 128 * 8 + 1);
+    VERIFICAR(i2c_simulado_bytes_escritos(i2c1) - inicio_b == BYTES_JANELA + 128 * 4 + 1);
+    VERIFICAR(!painel_a.dirty && !painel_b.dirty);
+
+    // Só o painel pendente é enviado
+    inicio_a = i2c_simulado_bytes_escritos(i2c0);
+    inicio_b = i2c_simulado_bytes_escritos(i2c1);
+    ssd1306_request_flush(&painel_b);
+    VERIFICAR(ssd1306_flush_all(paineis, 2) == 0);
+    VERIFICAR(i2c_simulado_bytes_escritos(i2c0) == inicio_a);
+    VERIFICAR(i2c_simulado_bytes_escritos(i2c1) - inicio_b == BYTES_JANELA + 128 * 4 + 1);
+}
+
+void testar_nack()
+{
+    ssd1306_t *paineis[] = {&painel_a, &painel_b};
+
+    i2c_simulado_simular_nack(i2c1, true);
+    size_t transacoes_b = i2c1->transacoes;
+    ssd1306_request_flush(&painel_a);
+    ssd1306_request_flush(&painel_b);
+    VERIFICAR(ssd1306_flush_all(paineis, 2) == 1);
+
+    // Uma única tentativa por chamada, mesmo com o outro painel ainda enviando
+    VERIFICAR(i2c1->transacoes - transacoes_b == COMANDOS_JANELA);
+    VERIFICAR(!painel_a.dirty);
+    VERIFICAR(painel_b.dirty && painel_b.flush_failed);
+
+    // O painel que falhou é tentado de novo na próxima chamada
+    i2c_simulado_simular_nack(i2c1, false);
+    VERIFICAR(ssd1306_flush_all(paineis, 2) == 0);
+    VERIFICAR(!painel_b.dirty && !painel_b.flush_failed);
+}
+
+// Tempo para enviar QUADROS_TAXA quadros de cada painel
+uint64_t medir_quadros(ssd1306_t *primeiro, ssd1306_t *segundo)
+{
+    ssd1306_t *paineis[] = {primeiro, segundo};
+
+    uint64_t inicio = time_us_64();
+    for (uint32_t i = 0; i < QUADROS_TAXA; i++)
+    {
+        ssd1306_request_flush(primeiro);
+        ssd1306_request_flush(segundo);
+        VERIFICAR(ssd1306_flush_all(paineis, 2) == 0);
+    }
+    uint64_t total_us = time_us_64() - inicio;
+    return total_us ? total_us : 1;
+}
+
+void testar_taxa_agregada()
+{
+    // Os mesmos dois tamanhos de painel, com endereços diferentes no i2c0
+    ssd1306_t mesmo_a;
+    ssd1306_t mesmo_b;
+    ssd1306_init(&mesmo_a, 128, 64, false, ENDERECO_I2C, i2c0);
+    ssd1306_init(&mesmo_b, 128, 32, false, ENDERECO_I2C + 1, i2c0);
+
+    i2c_simulado_simular_tempo(i2c0, true);
+    i2c_simulado_simular_tempo(i2c1, true);
+    uint64_t paralelo_us = medir_quadros(&painel_a, &painel_b);
+    uint64_t mesmo_us = medir_quadros(&mesmo_a, &mesmo_b);
+    i2c_simulado_simular_tempo(i2c0, false);
+    i2c_simulado_simular_tempo(i2c1, false);
+
+    // O quadro maior não pode sair mais rápido que o barramento permite
+    uint64_t minimo_us = (uint64_t)QUADROS_TAXA * (128 * 8 + 1) * 9 * 1000000 / VELOCIDADE_I2C;
+    VERIFICAR(paralelo_us >= minimo_us);
+
+    // Em paralelo o tempo é o do painel maior; num só barramento é a soma dos
+    // dois (cerca de 1,5 vez)
+    VERIFICAR(paralelo_us * 5 < mesmo_us * 4);
+
+    printf("{\"nome\":\"ssd1306_flush_all_2_paineis\",\"quadros\":%u,\"paralelo_us\":%llu,\"mesmo_barramento_us\":%llu,\"quadros_por_s\":%llu}\n",
+           2 * QUADROS_TAXA, (unsigned long long)paralelo_us, (unsigned long long)mesmo_us,
+           (unsigned long long)(2ull * QUADROS_TAXA * 1000000 / paralelo_us));
+
+    free(mesmo_a.ram_buffer);
+    free(mesmo_b.ram_buffer);
+}
+
+int main()
+{
+    i2c_init(i2c0, VELOCIDADE_I2C);
+    i2c_init(i2c1, VELOCIDADE_I2C);
+
+    ssd1306_init(&painel_a, 128, 64, false, ENDERECO_I2C, i2c0);
+    ssd1306_init(&painel_b, 128, 32, false, ENDERECO_I2C, i2c1);
+    ssd1306_config(&painel_a);
+    ssd1306_config(&painel_b);
+
+    testar_isolamento();
+    testar_bytes_por_barramento();
+    testar_nack();
+    testar_taxa_agregada();
+
+    if (falhas)
+    {
+        printf("%d verificações falharam\n", falhas);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "lib/ssd1306.h"
+
+// Transição por linha inicial (ssd1306_roll_in) em painéis de 64 e 32 linhas,
+// conferida pelos comandos registrados no barramento simulado, e rolagem
+// horizontal em software, conferida no framebuffer.
+
+#define ENDERECO_I2C 0x3C
+#define MAX_LINHAS 64
+
+#define VERIFICAR(condicao)                                              \
+    do                                                                   \
+    {                                                                    \
+        if (!(condicao))                                                 \
+        {                                                                \
+            printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #condicao); \
+            falhas++;                                                    \
+        }                                                                \
+    } while (0)
+
+int falhas = 0;
+
+ssd1306_t painel_a;
+ssd1306_t painel_b;
+
+// Extrai, em ordem, as linhas iniciais enviadas ao barramento, pulando os
+// argumentos dos comandos que os têm
+size_t linhas_iniciais(i2c_inst_t *i2c, uint8_t *linhas)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < i2c->num_comandos && i < I2C_SIMULADO_MAX_COMANDOS; i++)
+    {
+        uint8_t comando = i2c->comandos[i];
+        if (comando == SET_COL_ADDR || comando == SET_PAGE_ADDR || comando == SET_VERT_SCROLL_AREA)
+            i += 2;
+        else if (comando == SET_HORIZ_SCROLL || comando == SET_HORIZ_SCROLL + 1)
+            i += 6;
+        else if (comando == SET_DIAG_SCROLL || comando == SET_DIAG_SCROLL + 1)
+            i += 5;
+        else if ((comando & 0xC0) == SET_DISP_START_LINE && total < MAX_LINHAS)
+            linhas[total++] = comando & 0x3F;
+    }
+    return total;
+}
+
+void desenhar_padrao(ssd1306_t *ssd)
+{
+    ssd1306_fill(ssd, false);
+    ssd1306_draw_string(ssd, "NIVEL 1", 0, 0);
+    ssd1306_hline(ssd, 0, ssd->width - 1, ssd->height - 1, true);
+}
+
+void testar_roll_in(ssd1306_t *ssd, uint8_t passo, uint8_t primeira_linha)
+{
+    uint8_t copia[128 * 8 + 1];
+    uint8_t linhas[MAX_LINHAS];
+
+    desenhar_padrao(ssd);
+    memcpy(copia, ssd->ram_buffer, ssd->bufsize);
+    i2c_simulado_limpar_comandos(ssd->i2c_port);
+
+    ssd1306_roll_in(ssd, passo, 0);
+
+    // Desce de primeira_linha de passo em passo e termina em 0
+    size_t total = linhas_iniciais(ssd->i2c_port, linhas);
+    VERIFICAR(total == (size_t)(primeira_linha - 1) / passo + 2);
+    for (size_t i = 0; i + 1 < total; i++)
+        VERIFICAR(linhas[i] == primeira_linha - i * passo);
+    VERIFICAR(total > 0 && linhas[total - 1] == 0);
+
+    // O framebuffer termina com o conteúdo original
+    VERIFICAR(memcmp(copia, ssd->ram_buffer, ssd->bufsize) == 0);
+}
+
+uint8_t coluna(ssd1306_t *ssd, const uint8_t *buffer, uint8_t x, uint8_t pagina)
+{
+    return buffer[x * ssd->pages + pagina + 1];
+}
+
+void testar_rolagem_software()
+{
+    uint8_t copia[128 * 8 + 1];
+
+    desenhar_padrao(&painel_a);
+    ssd1306_draw_string(&painel_a, "NIVEL 1", 35, 48);
+    memcpy(copia, painel_a.ram_buffer, painel_a.bufsize);
+
+    // Para a esquerda: cada coluna da página 6 recebe a seguinte e a primeira
+    // vai para o fim; as outras páginas não mudam
+    ssd1306_scroll_horizontal(&painel_a, true, 6, 6, SCROLL_5_FRAMES);
+    VERIFICAR(painel_a.scrolling);
+    for (uint8_t x = 0; x < 127; x++)
+        VERIFICAR(coluna(&painel_a, painel_a.ram_buffer, x, 6) == coluna(&painel_a, copia, x + 1, 6));
+    VERIFICAR(coluna(&painel_a, painel_a.ram_buffer, 127, 6) == coluna(&painel_a, copia, 0, 6));
+    for (uint8_t x = 0; x < 128; x++)
+    {
+        VERIFICAR(coluna(&painel_a, painel_a.ram_buffer, x, 0) == coluna(&painel_a, copia, x, 0));
+        VERIFICAR(coluna(&painel_a, painel_a.ram_buffer, x, 7) == coluna(&painel_a, copia, x, 7));
+    }
+
+    // Duas colunas para a direita desfazem a primeira e deslocam mais uma
+    ssd1306_scroll_horizontal(&painel_a, false, 6, 6, SCROLL_5_FRAMES);
+    VERIFICAR(memcmp(copia, painel_a.ram_buffer, painel_a.bufsize) == 0);
+    ssd1306_scroll_horizontal(&painel_a, false, 6, 6, SCROLL_5_FRAMES);
+    VERIFICAR(coluna(&painel_a, painel_a.ram_buffer, 0, 6) == coluna(&painel_a, copia, 127, 6));
+    for (uint8_t x = 1; x < 128; x++)
+        VERIFICAR(coluna(&painel_a, painel_a.ram_buffer, x, 6) == coluna(&painel_a, copia, x - 1, 6));
+
+    ssd1306_scroll_stop(&painel_a);
+    VERIFICAR(!painel_a.scrolling);
+}
+
+int main()
+{
+    i2c_init(i2c0, 400 * 1000);
+    i2c_init(i2c1, 400 * 1000);
+
+    ssd1306_init(&painel_a, 128, 64, false, ENDERECO_I2C, i2c0);
+    ssd1306_init(&painel_b, 128, 32, false, ENDERECO_I2C, i2c1);
+    ssd1306_config(&painel_a);
+    ssd1306_config(&painel_b);
+
+    // No painel de 32 linhas a transição começa na tela em branco (linha 32)
+    testar_roll_in(&painel_a, 4, 60);
+    testar_roll_in(&painel_b, 4, 32);
+    testar_roll_in(&painel_b, 5, 32);
+    testar_rolagem_software();
+
+    if (falhas)
+    {
+        printf("%d verificações falharam\n", falhas);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}